@@ -19,6 +19,7 @@
         'src/binding.cpp',
         'src/score_match.cpp',
         'src/MatcherBase.cpp',
+        'src/unicode.cpp',
       ],
       'conditions': [
         ['OS == "win"', {
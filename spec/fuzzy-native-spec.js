@@ -196,4 +196,67 @@ describe('fuzzy-native', function() {
       matchIndexes: indexes,
     }]);
   });
+
+  it('folds case beyond ASCII', function() {
+    matcher.setCandidates([
+      'src/Éclair.js',
+      'src/éclair.js',
+      'docs/ÜBER/straße.md',
+      'emoji/\ud83d\ude00abc.js',
+    ]);
+    var result = matcher.match('ÉCLAIR');
+    expect(values(result)).toEqual(['src/Éclair.js', 'src/éclair.js']);
+
+    result = matcher.match('über', {recordMatchIndexes: true});
+    expect(values(result)).toEqual(['docs/ÜBER/straße.md']);
+    expect(result[0].matchIndexes).toEqual([5, 6, 7, 8]);
+
+    result = matcher.match('Éclair', {caseSensitive: true});
+    expect(values(result)).toEqual(['src/Éclair.js']);
+
+    // Match indexes are UTF-16 indexes, so the emoji counts for two.
+    result = matcher.match('abc', {recordMatchIndexes: true});
+    expect(result[0].matchIndexes).toEqual([8, 9, 10]);
+  });
+
+  it('only uses smart case for uppercase beyond ASCII', function() {
+    matcher.setCandidates(['λόγος', 'ΛΌΓΟΣ']);
+    // Final sigma folds to σ, but it's lowercase.
+    var result = matcher.match('λόγος');
+    expect(values(result).sort()).toEqual(['ΛΌΓΟΣ', 'λόγος']);
+    expect(result[0].score).toEqual(1);
+    expect(result[1].score).toEqual(1);
+
+    result = matcher.match('ΛΌΓΟΣ');
+    expect(values(result)).toEqual(['ΛΌΓΟΣ', 'λόγος']);
+    expect(result[1].score).toBeLessThan(1);
+  });
+
+  it('matches ASCII candidates with queries that fold to ASCII', function() {
+    matcher.setCandidates([
+      'kelvin.txt',
+      'Kelvin.txt',
+      'ssk',
+      '\u212aelvin/\u017f.md',
+    ]);
+
+    // U+212A KELVIN SIGN folds to 'k', but never matches it exactly.
+    var result = matcher.match('\u212a', {recordMatchIndexes: true});
+    expect(values(result).slice(0, 2)).toEqual([
+      'ssk',
+      '\u212aelvin/\u017f.md',
+    ]);
+    expect(values(result).slice(2).sort()).toEqual(['Kelvin.txt', 'kelvin.txt']);
+    expect(result[2].score).toEqual(result[3].score);
+    expect(result.map(function(x) { return x.matchIndexes; }))
+      .toEqual([[2], [0], [0], [0]]);
+
+    result = matcher.match('\u212a', {caseSensitive: true});
+    expect(values(result)).toEqual(['\u212aelvin/\u017f.md']);
+
+    // U+017F LATIN SMALL LETTER LONG S folds to 's'.
+    result = matcher.match('\u017fk', {recordMatchIndexes: true});
+    expect(values(result)).toEqual(['ssk']);
+    expect(result[0].matchIndexes).toEqual([0, 2]);
+  });
 });
@@ -1,5 +1,6 @@
 #include "MatcherBase.h"
 #include "score_match.h"
+#include "unicode.h"
 
 #include <algorithm>
 #include <queue>
@@ -19,6 +20,22 @@ inline int letter_bitmask(const char *str) {
   return result;
 }
 
+/**
+ * Same bits as above for a-z. Non-ASCII code points are hashed into the
+ * remaining bits (26-30) so that non-ASCII queries can still be pruned.
+ */
+inline int letter_bitmask(const char32_t *str) {
+  int result = 0;
+  for (int i = 0; str[i]; i++) {
+    if (str[i] >= 'a' && str[i] <= 'z') {
+      result |= (1 << (str[i] - 'a'));
+    } else if (str[i] >= 0x80) {
+      result |= (1 << (26 + str[i] % 5));
+    }
+  }
+  return result;
+}
+
 inline string str_to_lower(const std::string &s) {
   string lower(s);
   for (auto& c : lower) {
@@ -29,6 +46,35 @@ inline string str_to_lower(const std::string &s) {
   return lower;
 }
 
+/**
+ * The query in both byte and code point form.
+ * The byte form is used for pure ASCII candidates, and the code point form
+ * for everything else.
+ */
+struct QueryData {
+  string query;
+  string query_case;
+  u32string query32;
+  u32string query32_case;
+  int bitmask;
+};
+
+/**
+ * Narrows code points to bytes for matching against ASCII candidates.
+ * Non-ASCII code points become 0xFF, which never occurs in an ASCII string,
+ * so they fail to match exactly as they would on code points. This lets
+ * queries like U+212A (KELVIN SIGN, which folds to 'k') stay on the byte path.
+ */
+inline string to_ascii_bytes(const u32string &str) {
+  string result(str.size(), '\xff');
+  for (size_t i = 0; i < str.size(); i++) {
+    if (str[i] < 0x80) {
+      result[i] = char(str[i]);
+    }
+  }
+  return result;
+}
+
 // Push a new entry on the heap while ensuring size <= max_results.
 void push_heap(ResultHeap &heap,
                float score,
@@ -42,8 +88,22 @@ void push_heap(ResultHeap &heap,
   }
 }
 
-vector<MatchResult> finalize(const string &query,
-                             const string &query_case,
+float score_codepoints(const QueryData &query,
+                       const MatchOptions &options,
+                       const u32string &codepoints,
+                       const u32string &folded,
+                       vector<int> *match_indexes = nullptr) {
+  return score_match(
+    codepoints.c_str(),
+    folded.c_str(),
+    query.query32.c_str(),
+    query.query32_case.c_str(),
+    options,
+    match_indexes
+  );
+}
+
+vector<MatchResult> finalize(const QueryData &query,
                              const MatchOptions &options,
                              bool record_match_indexes,
                              ResultHeap &&heap) {
@@ -51,16 +111,30 @@ vector<MatchResult> finalize(const string &query,
   while (heap.size()) {
     const MatchResult &result = heap.top();
     if (record_match_indexes) {
-      result.matchIndexes.reset(new vector<int>(query.size()));
-      string lower = str_to_lower(*result.value);
-      score_match(
-        result.value->c_str(),
-        lower.c_str(),
-        query.c_str(),
-        query_case.c_str(),
-        options,
-        result.matchIndexes.get()
-      );
+      result.matchIndexes.reset(new vector<int>(query.query32.size()));
+      if (is_ascii(*result.value)) {
+        string lower = str_to_lower(*result.value);
+        score_match(
+          result.value->c_str(),
+          lower.c_str(),
+          query.query.c_str(),
+          query.query_case.c_str(),
+          options,
+          result.matchIndexes.get()
+        );
+      } else {
+        u32string codepoints = utf8_to_codepoints(*result.value);
+        score_codepoints(query, options, codepoints, fold_case(codepoints),
+                         result.matchIndexes.get());
+        // Convert code point indexes to UTF-16 indexes to match JS strings.
+        vector<int> utf16_index(codepoints.size());
+        for (size_t i = 1; i < codepoints.size(); i++) {
+          utf16_index[i] = utf16_index[i - 1] + utf16_length(codepoints[i - 1]);
+        }
+        for (auto &index : *result.matchIndexes) {
+          index = utf16_index[index];
+        }
+      }
     }
     vec.push_back(result);
     heap.pop();
@@ -70,8 +144,7 @@ vector<MatchResult> finalize(const string &query,
 }
 
 void thread_worker(
-  const string &query,
-  const string &query_case,
+  const QueryData &query,
   const MatchOptions &options,
   size_t max_results,
   const vector<MatcherBase::CandidateData> &candidates,
@@ -79,17 +152,23 @@ void thread_worker(
   size_t end,
   ResultHeap &result
 ) {
-  int bitmask = letter_bitmask(query_case.c_str());
+  int bitmask = query.bitmask;
   for (size_t i = start; i < end; i++) {
     const auto &candidate = candidates[i];
     if ((bitmask & candidate.bitmask) == bitmask) {
-      float score = score_match(
-        candidate.value.c_str(),
-        candidate.lowercase.c_str(),
-        query.c_str(),
-        query_case.c_str(),
-        options
-      );
+      float score;
+      if (candidate.unicode == nullptr) {
+        score = score_match(
+          candidate.value.c_str(),
+          candidate.lowercase.c_str(),
+          query.query.c_str(),
+          query.query_case.c_str(),
+          options
+        );
+      } else {
+        score = score_codepoints(query, options, candidate.unicode->codepoints,
+                                 candidate.unicode->folded);
+      }
       if (score > 0) {
         push_heap(result, score, &candidate.value, max_results);
       }
@@ -112,24 +191,31 @@ vector<MatchResult> MatcherBase::findMatches(const std::string &query,
   string new_query;
   // Ignore all whitespace in the query.
   for (auto c : query) {
-    if (!isspace(c)) {
+    if (!isspace((unsigned char)c)) {
       new_query += c;
     }
-    if (isupper(c) && !matchOptions.case_sensitive) {
-      matchOptions.smart_case = true;
-    }
   }
 
-  string query_case;
+  QueryData query_data;
+  query_data.query32 = utf8_to_codepoints(new_query);
+  u32string folded = fold_case(query_data.query32);
   if (!options.case_sensitive) {
-    query_case = str_to_lower(new_query);
-  } else {
-    query_case = query;
+    for (auto c : query_data.query32) {
+      if (is_uppercase(c)) {
+        matchOptions.smart_case = true;
+        break;
+      }
+    }
   }
+  query_data.query32_case =
+    options.case_sensitive ? query_data.query32 : folded;
+  query_data.query = to_ascii_bytes(query_data.query32);
+  query_data.query_case = to_ascii_bytes(query_data.query32_case);
+  query_data.bitmask = letter_bitmask(folded.c_str());
 
   ResultHeap combined;
   if (num_threads == 0 || candidates_.size() < 10000) {
-    thread_worker(new_query, query_case, matchOptions, max_results,
+    thread_worker(query_data, matchOptions, max_results,
                   candidates_, 0, candidates_.size(), combined);
   } else {
     vector<ResultHeap> thread_results(num_threads);
@@ -143,8 +229,7 @@ vector<MatchResult> MatcherBase::findMatches(const std::string &query,
       }
       threads.emplace_back(
         thread_worker,
-        ref(new_query),
-        ref(query_case),
+        ref(query_data),
         ref(matchOptions),
         max_results,
         ref(candidates_),
@@ -166,8 +251,7 @@ vector<MatchResult> MatcherBase::findMatches(const std::string &query,
   }
 
   return finalize(
-    new_query,
-    query_case,
+    query_data,
     matchOptions,
     options.record_match_indexes,
     move(combined)
@@ -177,12 +261,18 @@ vector<MatchResult> MatcherBase::findMatches(const std::string &query,
 void MatcherBase::addCandidate(const string &candidate) {
   auto it = lookup_.find(candidate);
   if (it == lookup_.end()) {
-    string lowercase = str_to_lower(candidate);
     lookup_[candidate] = candidates_.size();
     CandidateData data;
     data.value = candidate;
-    data.bitmask = letter_bitmask(lowercase.c_str());
-    data.lowercase = move(lowercase);
+    if (is_ascii(candidate)) {
+      data.lowercase = str_to_lower(candidate);
+      data.bitmask = letter_bitmask(data.lowercase.c_str());
+    } else {
+      data.unicode.reset(new UnicodeData());
+      data.unicode->codepoints = utf8_to_codepoints(candidate);
+      data.unicode->folded = fold_case(data.unicode->codepoints);
+      data.bitmask = letter_bitmask(data.unicode->folded.c_str());
+    }
     candidates_.emplace_back(move(data));
   }
 }
@@ -37,16 +37,31 @@ struct MatchResult {
 
 class MatcherBase {
 public:
+  // Code point data for candidates that aren't pure ASCII.
+  struct UnicodeData {
+    std::u32string codepoints;
+    // Unicode simple case folding of `codepoints`.
+    std::u32string folded;
+  };
+
   struct CandidateData {
     std::string value;
+    // Only set for pure ASCII candidates.
     std::string lowercase;
     /**
      * A bitmask of the letters (a-z) contained in the string.
      * ('a' = 1, 'b' = 2, 'c' = 4, ...)
      * We can then compute the bitmask of the query and very quickly prune out
      * non-matches in many practical cases.
+     * Non-ASCII code points (after case folding) are hashed into bits 26-30.
      */
     int bitmask;
+    /**
+     * Pure ASCII candidates are matched byte by byte, and this is null.
+     * Everything else is matched on code points. This is kept out of line so
+     * the table stays compact for the (common) ASCII case.
+     */
+    std::unique_ptr<UnicodeData> unicode;
   };
 
   std::vector<MatchResult> findMatches(const std::string &query,
@@ -7,7 +7,6 @@
  */
 
 #include <string>
-#include <cstring>
 
 using namespace std;
 
@@ -24,12 +23,14 @@ const float MIN_DISTANCE_PENALTY = 0.2 + 1e-9;
 const size_t MAX_MEMO_SIZE = 10000;
 
 // Convenience structure for passing around during recursion.
+// CharT is either a UTF-8/ASCII byte or a full code point.
+template <typename CharT>
 struct MatchInfo {
-  const char *haystack;
-  const char *haystack_case;
+  const CharT *haystack;
+  const CharT *haystack_case;
   size_t haystack_len;
-  const char *needle;
-  const char *needle_case;
+  const CharT *needle;
+  const CharT *needle_case;
   size_t needle_len;
   int* last_match;
   float *memo;
@@ -59,7 +60,8 @@ struct MatchInfo {
  * We use a memoized-recursive implementation, since the state space tends to
  * be relatively sparse in most practical use cases.
  */
-float recursive_match(const MatchInfo &m,
+template <typename CharT>
+float recursive_match(const MatchInfo<CharT> &m,
                       const size_t haystack_idx,
                       const size_t needle_idx) {
   if (needle_idx == m.needle_len) {
@@ -73,7 +75,7 @@ float recursive_match(const MatchInfo &m,
 
   float score = 0;
   size_t best_match = 0;
-  char c = m.needle_case[needle_idx];
+  CharT c = m.needle_case[needle_idx];
 
   size_t lim = m.last_match[needle_idx];
   if (needle_idx > 0 && m.max_gap && haystack_idx + m.max_gap < lim) {
@@ -85,7 +87,7 @@ float recursive_match(const MatchInfo &m,
   size_t last_slash = 0;
   float dist_penalty = BASE_DISTANCE_PENALTY;
   for (size_t j = haystack_idx; j <= lim; j++) {
-    char d = m.haystack_case[j];
+    CharT d = m.haystack_case[j];
     if (needle_idx == 0 && (d == '/' || d == '\\')) {
       last_slash = j;
     }
@@ -93,8 +95,8 @@ float recursive_match(const MatchInfo &m,
       // calculate score
       float char_score = 1.0;
       if (j > haystack_idx) {
-        char last = m.haystack[j - 1];
-        char curr = m.haystack[j]; // case matters, so get again
+        CharT last = m.haystack[j - 1];
+        CharT curr = m.haystack[j]; // case matters, so get again
         if (last == '/') {
           char_score = 0.9;
         } else if (last == '-' || last == '_' || last == ' ' ||
@@ -140,19 +142,20 @@ float recursive_match(const MatchInfo &m,
   return memoized = score;
 }
 
-float score_match(const char *haystack,
-                  const char *haystack_lower,
-                  const char *needle,
-                  const char *needle_lower,
-                  const MatchOptions &options,
-                  vector<int> *match_indexes) {
+template <typename CharT>
+float score_match_impl(const CharT *haystack,
+                       const CharT *haystack_lower,
+                       const CharT *needle,
+                       const CharT *needle_lower,
+                       const MatchOptions &options,
+                       vector<int> *match_indexes) {
   if (!*needle) {
     return 1.0;
   }
 
-  MatchInfo m;
-  m.haystack_len = strlen(haystack);
-  m.needle_len = strlen(needle);
+  MatchInfo<CharT> m;
+  m.haystack_len = char_traits<CharT>::length(haystack);
+  m.needle_len = char_traits<CharT>::length(needle);
   m.haystack_case = options.case_sensitive ? haystack : haystack_lower;
   m.needle_case = options.case_sensitive ? needle : needle_lower;
   m.smart_case = options.smart_case;
@@ -231,3 +234,23 @@ float score_match(const char *haystack,
 
   return score;
 }
+
+float score_match(const char *haystack,
+                  const char *haystack_lower,
+                  const char *needle,
+                  const char *needle_lower,
+                  const MatchOptions &options,
+                  vector<int> *match_indexes) {
+  return score_match_impl(haystack, haystack_lower, needle, needle_lower,
+                          options, match_indexes);
+}
+
+float score_match(const char32_t *haystack,
+                  const char32_t *haystack_lower,
+                  const char32_t *needle,
+                  const char32_t *needle_lower,
+                  const MatchOptions &options,
+                  vector<int> *match_indexes) {
+  return score_match_impl(haystack, haystack_lower, needle, needle_lower,
+                          options, match_indexes);
+}
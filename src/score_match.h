@@ -26,3 +26,14 @@ float score_match(const char *haystack,
                   const char *needle_lower,
                   const MatchOptions &options,
                   std::vector<int> *match_indexes = nullptr);
+
+/**
+ * Same as above, but operates on code points rather than bytes.
+ * Match indexes are code point indexes.
+ */
+float score_match(const char32_t *haystack,
+                  const char32_t *haystack_lower,
+                  const char32_t *needle,
+                  const char32_t *needle_lower,
+                  const MatchOptions &options,
+                  std::vector<int> *match_indexes = nullptr);
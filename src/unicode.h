@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Returns the Unicode simple case folding of c (one code point to one code
+ * point). Within ASCII this is the same as lowercasing.
+ */
+char32_t fold_case(char32_t c);
+std::u32string fold_case(const std::u32string &str);
+
+/**
+ * Returns true if c is an upper- or titlecase letter: it changes under case
+ * folding, and isn't one of the few lowercase letters that also do
+ * (e.g. final sigma U+03C2, which folds to U+03C3).
+ */
+bool is_uppercase(char32_t c);
+
+bool is_ascii(const std::string &str);
+
+/**
+ * Decodes UTF-8 into code points.
+ * Invalid bytes are decoded as U+FFFD, one per byte.
+ */
+std::u32string utf8_to_codepoints(const std::string &str);
+
+// Number of UTF-16 code units needed to encode c (i.e. its length in JS).
+inline size_t utf16_length(char32_t c) {
+  return c >= 0x10000 ? 2 : 1;
+}